@@ -0,0 +1,52 @@
+// argvx - Copyright (C) XnLogicaL 2025
+// Licensed under GNU GPL v3.0; see {root}/LICENSE
+
+// batch<T> throughput over a synthetic manifest at increasing thread counts.
+// Usage: argvx-bench-batch [lines] [max threads, default: all cores]
+
+#include <algorithm>
+#include <argvx/batch.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <format>
+#include <string>
+#include <thread>
+
+struct job {
+  int64_t jobs = 1;
+  bool verbose = false;
+  std::string target, input;
+};
+
+static void job_schema(argvx::parser<>& parser, job& j) {
+  parser.positional("input", j.input).required();
+  parser.option({"--jobs", "-j"}, j.jobs);
+  parser.option({"--target", "-t"}, j.target);
+  parser.option({"--verbose", "-v"}, j.verbose);
+}
+
+int main(int argc, char** argv) {
+  size_t lines = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+
+  std::string manifest;
+  for (size_t i = 0; i < lines; ++i)
+    manifest += std::format("tool --jobs={} -t 'release {}' src/{}.cpp{}\n",
+                            i % 64, i % 3, i, i % 5 ? "" : " -v");
+
+  double base = 0;
+  size_t cores = std::max(1u, std::thread::hardware_concurrency());
+  size_t max_threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : cores;
+  for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+    argvx::batch<job> batch(job_schema, {}, threads);
+    auto start = std::chrono::steady_clock::now();
+    auto res = batch.parse(manifest);
+    auto end = std::chrono::steady_clock::now();
+
+    double secs = std::chrono::duration<double>(end - start).count();
+    if (threads == 1) base = secs;
+    std::printf("%3zu threads: %8.3fs  %10.0f lines/s  x%.2f  (%zu errors)\n",
+                threads, secs, lines / secs, base / secs, res.errors.size());
+  }
+}
@@ -0,0 +1,23 @@
+#!/usr/bin/env bash
+# Times a clean build of each compile benchmark target.
+# usage: bench/compile/run.sh [build-dir] [tu-count]
+set -e
+
+root="$(cd "$(dirname "$0")/../.." && pwd)"
+build="${1:-$root/build-bench}"
+tus="${2:-200}"
+
+cmake -S "$root" -B "$build" -G Ninja \
+  -D ARGVX_BUILD_BENCH=ON \
+  -D ARGVX_BUILD_MODULE=ON \
+  -D ARGVX_BUILD_PCH=ON \
+  -D ARGVX_BENCH_TUS="$tus" >/dev/null
+
+for mode in include pch module; do
+  cmake --build "$build" --target clean >/dev/null
+  start=$(date +%s.%N)
+  cmake --build "$build" --target "argvx-bench-compile-$mode" >/dev/null
+  end=$(date +%s.%N)
+  awk -v s="$start" -v e="$end" -v m="$mode" -v n="$tus" \
+    'BEGIN { printf "%-8s %4s TUs: %6.2fs\n", m, n, e - s }'
+done
@@ -0,0 +1,111 @@
+// argvx - Copyright (C) XnLogicaL 2025
+// Licensed under GNU GPL v3.0; see {root}/LICENSE
+
+// command_line::tokenize() + parser(args) versus the usual hand-rolled split
+// into std::vector<std::string> plus a char* array for parser(argc, argv).
+
+#include <argvx/parser.hpp>
+#include <argvx/tokenizer.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+static constexpr std::string_view lines[] = {
+    "build --jobs=8 --target release src/main.cpp",
+    "build -j 4 --target 'debug build' \"src/some dir/main.cpp\"",
+    "build --verbose --jobs=16 --target=x86_64 src/a\\ b.cpp",
+};
+
+static constexpr size_t iterations = 1'000'000;
+
+static std::vector<std::string> split(std::string_view source) {
+  std::vector<std::string> out;
+  std::string current;
+  bool in_token = false;
+  char quote = '\0';
+
+  for (size_t i = 0; i < source.size(); ++i) {
+    char c = source[i];
+    if (quote) {
+      if (c == quote)
+        quote = '\0';
+      else if (c == '\\' && quote == '"' && i + 1 < source.size())
+        current += source[++i];
+      else
+        current += c;
+    } else if (c == '\'' || c == '"') {
+      quote = c;
+      in_token = true;
+    } else if (c == '\\' && i + 1 < source.size()) {
+      current += source[++i];
+      in_token = true;
+    } else if (argvx::detail::is_space(c)) {
+      if (in_token) out.push_back(std::move(current));
+      current.clear();
+      in_token = false;
+    } else {
+      current += c;
+      in_token = true;
+    }
+  }
+  if (in_token) out.push_back(std::move(current));
+  return out;
+}
+
+template <typename Parser>
+static int64_t run_schema(Parser& parser) {
+  int64_t jobs = 0;
+  bool verbose = false;
+  std::string target, input;
+
+  parser.positional("input", input);
+  parser.option({"--jobs", "-j"}, jobs);
+  parser.option({"--target", "-t"}, target);
+  parser.option({"--verbose", "-v"}, verbose);
+  if (parser.parse()) return -1;
+  return jobs + verbose + static_cast<int64_t>(input.size());
+}
+
+template <typename F>
+static void bench(const char* name, F&& body) {
+  int64_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i)
+    sink += body(lines[i % std::size(lines)]);
+  auto end = std::chrono::steady_clock::now();
+
+  double ns = std::chrono::duration<double, std::nano>(end - start).count();
+  std::printf("%-28s %8.1f ns/line  (sink %lld)\n", name, ns / iterations,
+              static_cast<long long>(sink));
+}
+
+int main() {
+  bench("split + argv", [](std::string_view line) -> int64_t {
+    auto tokens = split(line);
+    std::vector<const char*> argv;
+    for (auto& token : tokens) argv.push_back(token.c_str());
+    return static_cast<int64_t>(argv.size());
+  });
+
+  bench("tokenize", [](std::string_view line) -> int64_t {
+    auto cmd = argvx::command_line::tokenize(line);
+    return static_cast<int64_t>(cmd->size());
+  });
+
+  bench("split + argv + parse", [](std::string_view line) {
+    auto tokens = split(line);
+    std::vector<const char*> argv;
+    for (auto& token : tokens) argv.push_back(token.c_str());
+    argvx::parser parser(argv.size(), argv.data());
+    return run_schema(parser);
+  });
+
+  bench("tokenize + parse", [](std::string_view line) {
+    auto cmd = argvx::command_line::tokenize(line);
+    argvx::parser parser(cmd->args());
+    return run_schema(parser);
+  });
+}
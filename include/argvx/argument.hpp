@@ -3,9 +3,11 @@
 
 #pragma once
 
-#include <functional>
+#include <expected>
+#include <memory_resource>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "policy.hpp"
@@ -15,7 +17,7 @@ namespace argvx {
 namespace detail {
 
 struct option_names {
-  std::string long_name{}, short_name{};
+  std::string_view long_name{}, short_name{};
 
   inline bool one_defined() {
     return !(long_name.empty() && short_name.empty());
@@ -23,8 +25,20 @@ struct option_names {
 };
 
 using bind_result_t = std::optional<std::string>;
-using bind_function_t = std::function<bind_result_t(
-    const value&)>;  // TODO: use std::copyable_function when C++26
+
+// Type-erased store into the bound object; a plain function pointer so that
+// binding needs no heap-allocated closure state.
+using bind_function_t = bind_result_t (*)(void* target, std::string_view name,
+                                          value&& value);
+
+// Lazy arguments (see lazy.hpp) only record their token during parse() and
+// convert it through `convert` on first access.
+using convert_function_t = std::expected<value, std::string> (*)(
+    std::string_view raw, const std::type_info& type);
+using defer_function_t = void (*)(void* target, std::string_view token,
+                                  std::string_view raw,
+                                  convert_function_t convert);
+using validate_function_t = bind_result_t (*)(void* target);
 
 }  // namespace detail
 
@@ -39,25 +53,54 @@ class argument final {
   template <detail::prefix_policy, detail::delim_policy>
   friend class parser;
 
+ public:
+  using allocator_type = std::pmr::polymorphic_allocator<>;
+
  public:
   explicit argument(const std::type_info& type,
-                    std::vector<std::string>&& names,
-                    detail::bind_function_t&& bind)
-      : m_type(type), m_names(names), m_bind(bind) {}
+                    std::pmr::vector<std::pmr::string>&& names, void* target,
+                    detail::bind_function_t bind, allocator_type alloc = {})
+      : m_type(type),
+        m_names(std::move(names), alloc),
+        m_target(target),
+        m_bind(bind),
+        m_help(alloc) {}
+
+  // Copies the registration, names and help into `alloc`; the target is
+  // shared, not copied.
+  argument(const argument& other, allocator_type alloc)
+      : m_type(other.m_type),
+        m_names(other.m_names, alloc),
+        m_target(other.m_target),
+        m_bind(other.m_bind),
+        m_defer(other.m_defer),
+        m_validate(other.m_validate),
+        m_provided(other.m_provided),
+        m_required(other.m_required),
+        m_help(other.m_help, alloc) {}
 
  public:
-  auto name() const { return m_names.front(); }
+  allocator_type get_allocator() const { return m_help.get_allocator(); }
+  std::string_view name() const { return m_names.front(); }
   argument& required() { SELF(m_required = true); }
-  argument& help(std::string help) { SELF(m_help = help); }
+  argument& help(std::string_view help) { SELF(m_help = help); }
+
+ private:
+  detail::bind_result_t m_bind_value(value&& value) {
+    return m_bind(m_target, name(), std::move(value));
+  }
 
  private:
   const std::type_info& m_type;
-  std::vector<std::string> m_names;
+  std::pmr::vector<std::pmr::string> m_names;
+  void* m_target;
   detail::bind_function_t m_bind;
+  detail::defer_function_t m_defer = nullptr;
+  detail::validate_function_t m_validate = nullptr;
 
   bool m_provided = false;
   bool m_required = false;
-  std::string m_help;
+  std::pmr::string m_help;
 };
 
 #undef SELF
@@ -0,0 +1,320 @@
+// argvx - Copyright (C) XnLogicaL 2025
+// Licensed under GNU GPL v3.0; see {root}/LICENSE
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+#include "parser.hpp"
+#include "policy.hpp"
+#include "tokenizer.hpp"
+#include "value.hpp"
+
+namespace argvx {
+namespace detail {
+
+// Read-only view of a whole file; memory-mapped where the platform allows.
+class mapped_file final {
+ public:
+  static std::expected<mapped_file, std::string> open(const fs::path& path);
+
+ public:
+  mapped_file(mapped_file&& other) noexcept
+      : m_data(std::exchange(other.m_data, nullptr)),
+        m_size(std::exchange(other.m_size, 0)) {
+#if !__has_include(<sys/mman.h>)
+    m_buffer = std::move(other.m_buffer);
+    m_data = m_buffer.data();
+#endif
+  }
+
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+  mapped_file& operator=(mapped_file&&) = delete;
+
+  ~mapped_file() {
+#if __has_include(<sys/mman.h>)
+    if (m_data) ::munmap(const_cast<char*>(m_data), m_size);
+#endif
+  }
+
+ public:
+  std::string_view view() const { return {m_data, m_size}; }
+
+ private:
+  mapped_file() = default;
+
+ private:
+  const char* m_data = nullptr;
+  size_t m_size = 0;
+#if !__has_include(<sys/mman.h>)
+  std::string m_buffer;
+#endif
+};
+
+inline std::expected<mapped_file, std::string> mapped_file::open(
+    const fs::path& path) {
+  mapped_file file;
+#if __has_include(<sys/mman.h>)
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return std::unexpected(std::format("{}: {}", path.string(),
+                                       std::strerror(errno)));
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    int err = errno;
+    ::close(fd);
+    return std::unexpected(std::format("{}: {}", path.string(),
+                                       std::strerror(err)));
+  }
+
+  if (st.st_size > 0) {
+    void* data = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      int err = errno;
+      ::close(fd);
+      return std::unexpected(std::format("{}: {}", path.string(),
+                                         std::strerror(err)));
+    }
+    file.m_data = static_cast<const char*>(data);
+    file.m_size = static_cast<size_t>(st.st_size);
+  }
+  ::close(fd);
+#else
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return std::unexpected(std::format("{}: cannot open", path.string()));
+  file.m_buffer.assign(std::istreambuf_iterator<char>(in), {});
+  file.m_data = file.m_buffer.data();
+  file.m_size = file.m_buffer.size();
+#endif
+  return file;
+}
+
+}  // namespace detail
+
+// Parses a manifest where every line is a full command line (argv[0]
+// included) for the same tool. The manifest is cut into byte chunks at line
+// boundaries; workers first count the lines of each chunk, then parse them.
+// Each worker registers the schema once against its own scratch T and reuses
+// that parser and one token buffer for every line it claims, constructing the
+// chunk's result slots itself. Blank lines keep the initial value.
+template <typename T, detail::prefix_policy Pp = prefix_policy<"--", "-">,
+          detail::delim_policy Dp = delim_policy<'=', ','>>
+class batch final {
+ public:
+  using parser_type = parser<Pp, Dp>;
+  using schema_function_t = std::function<void(parser_type&, T&)>;
+
+  struct error {
+    size_t line;  // 1-based
+    std::string message;
+  };
+
+  // Fixed-size array of results. Its slots start out raw and are constructed
+  // by the worker that parses the line, so no thread initializes the whole
+  // array up front. parse() constructs every slot before returning it.
+  class slot_array final {
+   public:
+    friend class batch;
+
+   public:
+    slot_array() = default;
+
+    slot_array(slot_array&& other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr)),
+          m_size(std::exchange(other.m_size, 0)) {}
+
+    slot_array& operator=(slot_array&& other) noexcept {
+      std::swap(m_data, other.m_data);
+      std::swap(m_size, other.m_size);
+      return *this;
+    }
+
+    slot_array(const slot_array&) = delete;
+    slot_array& operator=(const slot_array&) = delete;
+
+    ~slot_array() {
+      if (!m_data) return;
+      std::destroy_n(m_data, m_size);
+      std::allocator<T>{}.deallocate(m_data, m_size);
+    }
+
+   public:
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    T& operator[](size_t index) { return m_data[index]; }
+    const T& operator[](size_t index) const { return m_data[index]; }
+
+    T* begin() { return m_data; }
+    T* end() { return m_data + m_size; }
+    const T* begin() const { return m_data; }
+    const T* end() const { return m_data + m_size; }
+
+   private:
+    explicit slot_array(size_t size)
+        : m_data(size ? std::allocator<T>{}.allocate(size) : nullptr),
+          m_size(size) {}
+
+    template <typename... Args>
+    void m_construct(size_t index, Args&&... args) {
+      std::construct_at(m_data + index, std::forward<Args>(args)...);
+    }
+
+   private:
+    T* m_data = nullptr;
+    size_t m_size = 0;
+  };
+
+  struct result {
+    slot_array values;          // one per line
+    std::vector<error> errors;  // sorted by line
+  };
+
+ public:
+  explicit batch(schema_function_t schema, T initial = {},
+                 size_t threads = std::thread::hardware_concurrency())
+      : m_schema(std::move(schema)),
+        m_initial(std::move(initial)),
+        m_threads(std::max<size_t>(threads, 1)) {}
+
+ public:
+  template <detail::value_parser Vp = default_value_parser>
+  std::expected<result, std::string> parse_file(const fs::path& path) const {
+    auto file = detail::mapped_file::open(path);
+    if (!file.has_value()) return std::unexpected(file.error());
+    return parse<Vp>(file->view());
+  }
+
+  template <detail::value_parser Vp = default_value_parser>
+  result parse(std::string_view manifest) const {
+    // Chunk c starts at the first line start at or after c * chunk_bytes, so
+    // every line falls in exactly one chunk. Finding each start only scans to
+    // the next newline.
+    size_t chunks = (manifest.size() + chunk_bytes - 1) / chunk_bytes;
+    std::vector<size_t> bounds(chunks + 1, manifest.size());
+    bounds[0] = 0;
+    for (size_t chunk = 1; chunk < chunks; ++chunk) {
+      auto nl = manifest.find('\n', chunk * chunk_bytes - 1);
+      if (nl != std::string_view::npos) bounds[chunk] = nl + 1;
+    }
+
+    result res;
+    size_t workers = std::min(m_threads, chunks);
+    if (workers == 0) return res;
+
+    // Pass 1: count the lines of each chunk. A non-empty chunk holds one line
+    // per newline before its last byte, plus the line it starts with.
+    std::vector<size_t> first_line(chunks + 1, 0);
+    std::atomic<size_t> next_chunk = 0;
+    m_run(workers, [&](size_t) {
+      for (size_t chunk; (chunk = next_chunk.fetch_add(
+                              1, std::memory_order_relaxed)) < chunks;) {
+        size_t begin = bounds[chunk], end = bounds[chunk + 1];
+        if (begin < end)
+          first_line[chunk + 1] =
+              1 + std::count(manifest.data() + begin,
+                             manifest.data() + end - 1, '\n');
+      }
+    });
+    for (size_t chunk = 0; chunk < chunks; ++chunk)
+      first_line[chunk + 1] += first_line[chunk];
+
+    // Pass 2: parse. Chunks are claimed from a shared cursor, so a worker that
+    // runs out simply takes the next unclaimed chunk instead of idling.
+    res.values = slot_array(first_line[chunks]);
+    std::vector<std::vector<error>> errors(workers);
+    next_chunk = 0;
+
+    // Every slot must be constructed before res.values is destroyed, so a
+    // throwing copy of T terminates here just as it would on a worker thread.
+    m_run(workers, [&](size_t worker) noexcept {
+      T scratch = m_initial;
+      parser_type parser(std::span<const std::string_view>{});
+      m_schema(parser, scratch);
+      command_line cmd;
+
+      for (size_t chunk; (chunk = next_chunk.fetch_add(
+                              1, std::memory_order_relaxed)) < chunks;) {
+        size_t line = first_line[chunk];
+        for (size_t pos = bounds[chunk]; pos < bounds[chunk + 1]; ++line) {
+          size_t nl = std::min(manifest.find('\n', pos), bounds[chunk + 1]);
+          auto text = manifest.substr(pos, nl - pos);
+          pos = nl + 1;
+
+          if (auto err = cmd.assign(text)) {
+            errors[worker].push_back({line + 1, std::move(*err)});
+            res.values.m_construct(line, m_initial);
+            continue;
+          }
+          if (cmd.size() == 0) {
+            res.values.m_construct(line, m_initial);
+            continue;
+          }
+
+          scratch = m_initial;
+          parser.reset(cmd.args());
+          // Lazy<> members are forced here, while the line's tokens are
+          // still alive; the stored value never needs them again.
+          auto err = parser.template parse<Vp>();
+          if (!err) err = parser.validate_all();
+          if (err) {
+            errors[worker].push_back({line + 1, std::move(*err)});
+            res.values.m_construct(line, m_initial);
+          } else {
+            res.values.m_construct(line, std::move(scratch));
+          }
+        }
+      }
+    });
+
+    for (auto& errs : errors)
+      std::move(errs.begin(), errs.end(), std::back_inserter(res.errors));
+    std::ranges::sort(res.errors, {}, &error::line);
+    return res;
+  }
+
+ private:
+  template <typename F>
+  static void m_run(size_t workers, const F& work) {
+    if (workers == 1) return work(0);
+    std::vector<std::thread> pool;
+    for (size_t worker = 0; worker < workers; ++worker)
+      pool.emplace_back(std::cref(work), worker);
+    for (auto& thread : pool) thread.join();
+  }
+
+ private:
+  static constexpr size_t chunk_bytes = 64 * 1024;
+
+  schema_function_t m_schema;
+  T m_initial;
+  size_t m_threads;
+};
+
+}  // namespace argvx
@@ -0,0 +1,87 @@
+// argvx - Copyright (C) XnLogicaL 2025
+// Licensed under GNU GPL v3.0; see {root}/LICENSE
+
+#pragma once
+
+#include <expected>
+#include <format>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <variant>
+
+#include "argument.hpp"
+#include "parser.hpp"
+#include "policy.hpp"
+#include "value.hpp"
+
+namespace argvx {
+
+// Deferred binding target. parse() only checks syntax and records the token;
+// conversion and type checking run on the first get() and the result, value
+// or error, is cached. Unprovided arguments yield the fallback value.
+//
+// The recorded token is a view into the parser's arguments, which must
+// outlive the first get(). The first get() is not thread-safe. live and batch
+// call parser::validate_all() before publishing, so lazy members of their
+// values are already converted.
+template <detail::value_alternative T>
+class lazy final {
+ public:
+  template <detail::prefix_policy, detail::delim_policy>
+  friend class parser;
+
+ public:
+  lazy() : lazy(T{}) {}
+  explicit lazy(T fallback) : m_cache(std::move(fallback)) {}
+
+ public:
+  bool provided() const { return m_provided; }
+
+  const std::expected<T, std::string>& get() const {
+    if (!m_cache) m_cache.emplace(m_convert_now());
+    return *m_cache;
+  }
+
+ private:
+  std::expected<T, std::string> m_convert_now() const {
+    auto value = m_convert(m_raw, typeid(T));
+    if (!value.has_value()) {
+      // Matches eager binding: a boolean flag whose value is missing or does
+      // not convert means true.
+      if constexpr (std::is_same_v<T, bool>) return true;
+      return std::unexpected(std::format("{}: {}", m_token, value.error()));
+    }
+    if (auto error = detail::type_check(m_token, *value, typeid(T)))
+      return std::unexpected(std::move(*error));
+    return std::get<T>(std::move(*value));
+  }
+
+  static void m_defer(void* target, std::string_view token,
+                      std::string_view raw,
+                      detail::convert_function_t convert) {
+    auto* self = static_cast<lazy*>(target);
+    self->m_provided = true;
+    self->m_token = token;
+    self->m_raw = raw;
+    self->m_convert = convert;
+    self->m_cache.reset();
+  }
+
+  static detail::bind_result_t m_validate(void* target) {
+    const auto& result = static_cast<const lazy*>(target)->get();
+    if (!result.has_value()) return result.error();
+    return std::nullopt;
+  }
+
+ private:
+  bool m_provided = false;
+  std::string_view m_token, m_raw;
+  detail::convert_function_t m_convert = nullptr;
+  mutable std::optional<std::expected<T, std::string>> m_cache;
+};
+
+}  // namespace argvx
@@ -0,0 +1,177 @@
+// argvx - Copyright (C) XnLogicaL 2025
+// Licensed under GNU GPL v3.0; see {root}/LICENSE
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "parser.hpp"
+#include "policy.hpp"
+#include "value.hpp"
+
+namespace argvx {
+
+// Hot-reloadable option set. Every reload() parses into a fresh T and, only if
+// parsing succeeds, publishes it with an atomic pointer swap. Readers pin the
+// current snapshot with read(), which never blocks or retries. Reader counts
+// are striped across cache lines by thread, so concurrent readers mostly
+// touch their own line rather than contending on a shared one.
+//
+// reload() never waits for readers. Replaced snapshots are retired and freed
+// by a later reload() or try_reclaim() once no reader can still hold them, so
+// a long-lived snapshot only delays reclamation. Snapshots must not outlive
+// the live object itself.
+template <typename T, detail::prefix_policy Pp = prefix_policy<"--", "-">,
+          detail::delim_policy Dp = delim_policy<'=', ','>>
+class live final {
+ public:
+  using parser_type = parser<Pp, Dp>;
+  using schema_function_t = std::function<void(parser_type&, T&)>;
+
+  class snapshot final {
+   public:
+    friend class live;
+
+   public:
+    snapshot(snapshot&& other) noexcept
+        : m_readers(std::exchange(other.m_readers, nullptr)),
+          m_value(other.m_value) {}
+
+    snapshot(const snapshot&) = delete;
+    snapshot& operator=(const snapshot&) = delete;
+    snapshot& operator=(snapshot&&) = delete;
+
+    ~snapshot() {
+      if (m_readers) m_readers->fetch_sub(1, std::memory_order_release);
+    }
+
+   public:
+    const T& operator*() const { return *m_value; }
+    const T* operator->() const { return m_value; }
+
+   private:
+    explicit snapshot(std::atomic<size_t>* readers, const T* value)
+        : m_readers(readers), m_value(value) {}
+
+   private:
+    std::atomic<size_t>* m_readers;
+    const T* m_value;
+  };
+
+ public:
+  explicit live(schema_function_t schema, T initial = {})
+      : m_schema(std::move(schema)),
+        m_initial(std::move(initial)),
+        m_current(new T(m_initial)) {}
+
+  live(const live&) = delete;
+  live& operator=(const live&) = delete;
+
+  // All snapshots must have been released by now.
+  ~live() {
+    delete m_current.load();
+    for (const auto& retired : m_retired) delete retired.value;
+  }
+
+ public:
+  snapshot read() const {
+    unsigned epoch = m_epoch.load(std::memory_order_seq_cst);
+    auto& readers = m_readers[epoch][m_stripe()].count;
+    readers.fetch_add(1, std::memory_order_seq_cst);
+    return snapshot(&readers, m_current.load(std::memory_order_seq_cst));
+  }
+
+  template <detail::value_parser Vp = default_value_parser>
+  std::optional<std::string> reload(size_t argc, const char* const* argv) {
+    std::lock_guard lock(m_reload_mutex);
+
+    auto next = std::make_unique<T>(m_initial);
+    parser_type parser(argc, argv);
+    m_schema(parser, *next);
+    if (auto error = parser.template parse<Vp>()) return *error;
+    // Force lazy<> members now: their tokens point into argv, and the
+    // published snapshot is read concurrently, so it must be fully converted.
+    if (auto error = parser.validate_all()) return *error;
+
+    const T* old =
+        m_current.exchange(next.release(), std::memory_order_seq_cst);
+    m_retired.push_back({old, m_grace});
+    m_reclaim();
+    return std::nullopt;
+  }
+
+  // Frees retired snapshots no reader can still hold, without waiting.
+  // Returns whether every retired snapshot has been freed.
+  bool try_reclaim() {
+    std::lock_guard lock(m_reload_mutex);
+    m_reclaim();
+    return m_retired.empty();
+  }
+
+ private:
+  static size_t m_stripe() {
+    static thread_local const size_t stripe =
+        std::hash<std::thread::id>{}(std::this_thread::get_id()) % stripes;
+    return stripe;
+  }
+
+  // A reader holding a retired snapshot bumped one of the two counter sets
+  // before it was retired. Each grace period ends with one set observed empty,
+  // so after two grace periods both sets have been, and the snapshot is free.
+  void m_reclaim() {
+    for (int pass = 0; pass < 2 && m_try_end_grace_period(); ++pass) {
+    }
+    std::erase_if(m_retired, [&](const retired& entry) {
+      if (m_grace < entry.grace + 2) return false;
+      delete entry.value;
+      return true;
+    });
+  }
+
+  // Ends the grace period if the inactive counter set is empty, then steers
+  // new readers to it so the previously active set can drain in turn.
+  bool m_try_end_grace_period() {
+    if (m_retired.empty()) return false;
+
+    unsigned inactive = m_epoch.load(std::memory_order_relaxed) ^ 1;
+    for (auto& stripe : m_readers[inactive])
+      if (stripe.count.load(std::memory_order_seq_cst) != 0) return false;
+
+    m_epoch.store(inactive, std::memory_order_seq_cst);
+    m_grace++;
+    return true;
+  }
+
+ private:
+  static constexpr size_t stripes = 16;
+
+  struct alignas(64) reader_count {
+    std::atomic<size_t> count = 0;
+  };
+
+  struct retired {
+    const T* value;
+    size_t grace;  // grace period in which it was retired
+  };
+
+  schema_function_t m_schema;
+  T m_initial;
+
+  std::atomic<const T*> m_current;
+  std::atomic<unsigned> m_epoch = 0;
+  mutable reader_count m_readers[2][stripes];
+  std::mutex m_reload_mutex;
+  std::vector<retired> m_retired;  // guarded by m_reload_mutex
+  size_t m_grace = 0;              // guarded by m_reload_mutex
+};
+
+}  // namespace argvx
@@ -3,13 +3,21 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <format>
+#include <functional>
+#include <memory_resource>
 #include <optional>
+#include <span>
+#include <string>
+#include <string_view>
 #include <type_traits>
 #include <typeinfo>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "argument.hpp"
 #include "policy.hpp"
@@ -22,22 +30,61 @@ namespace detail {
 template <typename T>
 struct binder {
   T* bind;
-  std::string name;
+  std::string_view name;
 
   template <typename U>
-  std::optional<std::string> operator()(const U& val) const {
-    if constexpr (std::is_same_v<T, U>) {
-      *bind = val;
+  std::optional<std::string> operator()(U&& val) const {
+    using V = std::remove_cvref_t<U>;
+    if constexpr (std::is_same_v<T, V>) {
+      *bind = std::forward<U>(val);
       return std::nullopt;
     } else {
       return std::format("{}: expected {}, got {}", name, type_name<T>(),
-                         type_name<U>());
+                         type_name<V>());
     }
   }
 };
 
+template <value_parser Vp>
+std::expected<value, std::string> convert_with(std::string_view raw,
+                                               const std::type_info& type) {
+  return Vp::parse(raw, type);
+}
+
+inline std::optional<std::string> type_check(std::string_view name,
+                                             const value& value,
+                                             const std::type_info& expected) {
+  const std::type_info& type = std::visit(
+      [](const auto& underlying) -> const std::type_info& {
+        return typeid(underlying);
+      },
+      value);
+
+  if (type != expected)
+    return std::format("{}: expected {}, got {} '{}'", name,
+                       type_name(expected), type_name(type), to_string(value));
+  return std::nullopt;
+}
+
+template <typename T>
+bind_result_t bind_to(void* target, std::string_view name, value&& value) {
+  return std::visit(binder<T>{static_cast<T*>(target), name},
+                    std::move(value));
+}
+
+struct string_hash {
+  using is_transparent = void;
+
+  size_t operator()(std::string_view sv) const {
+    return std::hash<std::string_view>{}(sv);
+  }
+};
+
 }  // namespace detail
 
+template <detail::value_alternative T>
+class lazy;
+
 template <detail::prefix_policy Pp = prefix_policy<"--", "-">,
           detail::delim_policy Dp = delim_policy<'=', ','>>
 class parser final {
@@ -45,67 +92,103 @@ class parser final {
   friend class argument;
 
  public:
-  explicit parser(size_t argc, const char* const* argv) : m_argv(argv, argc) {}
+  // Everything the parser owns (arguments, names, help strings, lookup
+  // tables) is allocated from `resource`, and parse() allocates nothing else
+  // itself. Bound values still allocate as their own types do when built from
+  // a token: a std::string longer than its small buffer allocates its text,
+  // and a fs::path does the same plus, with libstdc++, one allocation for the
+  // component list of a multi-component path. Targets are plain std types, so
+  // those allocations come from the global heap.
+  explicit parser(size_t argc, const char* const* argv,
+                  std::pmr::memory_resource* resource =
+                      std::pmr::get_default_resource())
+      : m_argv(argv, argc),
+        m_alloc(resource),
+        m_arguments(resource),
+        m_positionals(resource),
+        m_options(resource) {}
+
+  explicit parser(std::span<const std::string_view> args,
+                  std::pmr::memory_resource* resource =
+                      std::pmr::get_default_resource())
+      : m_args(args),
+        m_alloc(resource),
+        m_arguments(resource),
+        m_positionals(resource),
+        m_options(resource) {}
+
+  // A moved-from parser is left with no arguments registered.
+  parser(parser&& other) noexcept
+      : m_argv(other.m_argv),
+        m_args(other.m_args),
+        m_alloc(other.m_alloc),
+        m_arguments(std::move(other.m_arguments)),
+        m_positionals(std::move(other.m_positionals)),
+        m_options(std::move(other.m_options)) {
+    other.m_clear();
+  }
+
+  // Keeps this parser's resource. Arguments from a parser using another
+  // resource are re-created in this one, so the source resource may go away.
+  parser& operator=(parser&& other) {
+    if (this == &other) return *this;
+
+    m_destroy_arguments();
+    m_argv = other.m_argv;
+    m_args = other.m_args;
+    if (m_alloc == other.m_alloc) {
+      m_arguments = std::move(other.m_arguments);
+      m_positionals = std::move(other.m_positionals);
+      m_options = std::move(other.m_options);
+      other.m_clear();
+    } else {
+      m_copy_arguments(other);
+      other.m_destroy_arguments();
+    }
+    return *this;
+  }
+
+  parser(const parser&) = delete;
+  parser& operator=(const parser&) = delete;
+
+  ~parser() { m_destroy_arguments(); }
 
  public:
   template <detail::value_alternative T>
-  argument& positional(std::string name, T& bind) {
-    detail::require(!name.empty(), "positional must have non-empty name");
-
-    // REMINDER: do NOT use std::make_shared here as it breaks std::function
-    // move/copy semantics (nice one committee :|)
-    auto ptr = std::shared_ptr<argument>(new argument{
-        typeid(T),
-        {name},
-        [&bind, name](const value& value) -> detail::bind_result_t {
-          return std::visit(detail::binder<T>{&bind, name}, value);
-        }});
+  argument& positional(std::string_view name, T& bind) {
+    return m_add_positional(name, typeid(T), &bind, &detail::bind_to<T>);
+  }
 
-    m_positionals.push_back(ptr);
-    return *ptr;
+  template <detail::value_alternative T>
+  argument& positional(std::string_view name, lazy<T>& bind) {
+    return m_make_lazy<T>(m_add_positional(name, typeid(T), &bind, nullptr));
   }
 
   template <detail::value_alternative T>
   argument& option(detail::option_names option_names, T& bind) {
-    detail::require(option_names.one_defined(),
-                    "option must have at least one name");
-
-    std::string lname = option_names.long_name;
-    std::string sname = option_names.short_name;
-    std::vector<std::string> names;
-
-    if (!lname.empty()) {
-      detail::require(lname.starts_with(Pp::long_prefix),
-                      "long option name must start with long prefix");
-      names.push_back(lname);
-    }
-
-    if (!sname.empty()) {
-      detail::require(sname.starts_with(Pp::short_prefix),
-                      "short option name must start with short prefix");
-      names.push_back(sname);
-    }
-
-    std::string name = names.front();
+    return m_add_option(option_names, typeid(T), &bind, &detail::bind_to<T>);
+  }
 
-    // REMINDER: do NOT use std::make_shared here as it breaks std::function
-    // move/copy semantics (nice one committee :|)
-    auto ptr = std::shared_ptr<argument>(new argument{
-        typeid(T), std::move(names),
-        [&bind, name](const value& value) -> detail::bind_result_t {
-          return std::visit(detail::binder<T>{&bind, name}, value);
-        }});
+  template <detail::value_alternative T>
+  argument& option(detail::option_names option_names, lazy<T>& bind) {
+    return m_make_lazy<T>(
+        m_add_option(option_names, typeid(T), &bind, nullptr));
+  }
 
-    if (!lname.empty()) m_options[lname] = ptr;
-    if (!sname.empty()) m_options[sname] = ptr;
-    return *ptr;
+  // Points the parser at a new argument list and forgets which arguments were
+  // provided, so one registered schema can parse many command lines.
+  void reset(std::span<const std::string_view> args) {
+    m_argv = {};
+    m_args = args;
+    for (const auto& ptr : m_positionals) ptr->m_provided = false;
+    for (const auto& it : m_options) it.second->m_provided = false;
   }
 
   template <detail::value_parser Vp = default_value_parser>
   std::optional<std::string> parse() {
     size_t position = 0;
-    for (size_t index = 1; index < m_argv.size(); ++index) {
-      std::string_view token = m_argv[index];
+    for (size_t index = 1; index < m_arg_count(); ++index) {
+      std::string_view token = m_arg(index);
       if (token.starts_with(Pp::long_prefix)) {
         if (auto error = m_parse_long_opt<Vp>(token)) return *error;
       } else if (token.starts_with(Pp::short_prefix)) {
@@ -118,6 +201,15 @@ class parser final {
     return std::nullopt;
   }
 
+  // Converts every provided lazy argument now, reporting the first failure,
+  // for callers that want conversion errors up front.
+  std::optional<std::string> validate_all() {
+    for (argument* ptr : m_arguments)
+      if (ptr->m_validate && ptr->m_provided)
+        if (auto error = ptr->m_validate(ptr->m_target)) return *error;
+    return std::nullopt;
+  }
+
  private:
   template <detail::value_parser Vp>
   std::optional<std::string> m_parse_long_opt(std::string_view token) {
@@ -132,13 +224,20 @@ class parser final {
       raw = "";
     }
 
-    auto it = m_options.find(std::string(option));
+    auto it = m_options.find(option);
     if (it == m_options.end()) {
       return std::format("unknown option: {}", option);
     }
 
-    auto& opt = it->second;
+    argument* opt = it->second;
+    // Eager conversion of a missing value fails right here; a deferred one
+    // would only fail on first access, so reject it as a syntax error now.
+    if (opt->m_defer && delim == std::string::npos &&
+        opt->m_type != typeid(bool))
+      return std::format("{}: missing value", token);
+
     opt->m_provided = true;
+    if (m_defer<Vp>(*opt, token, raw)) return std::nullopt;
 
     auto value = Vp::parse(raw, opt->m_type);
     if (!value.has_value()) {
@@ -149,37 +248,44 @@ class parser final {
       return std::format("{}: {}", token, value.error());
     }
 
-    if (auto error = m_type_check(token, *value, *opt)) return *error;
+    if (auto error = detail::type_check(token, *value, opt->m_type))
+      return *error;
 
   bind_value:
-    if (auto error = opt->m_bind(*value)) return *error;
+    if (auto error = opt->m_bind_value(std::move(*value))) return *error;
     return std::nullopt;
   }
 
   template <detail::value_parser Vp>
   std::optional<std::string> m_parse_short_opt(std::string_view token,
                                                size_t& index) {
-    auto it = m_options.find(std::string(token));
+    auto it = m_options.find(token);
     if (it == m_options.end()) {
       return std::format("unknown option: {}", token);
     }
 
-    auto& opt = it->second;
+    argument* opt = it->second;
     opt->m_provided = true;
 
     if (opt->m_type == typeid(bool)) {
-      if (auto error = opt->m_bind(value(true))) {
+      if (m_defer<Vp>(*opt, token, "")) return std::nullopt;
+      if (auto error = opt->m_bind_value(value(true))) {
         return *error;
       }
     } else {
-      if (index == m_argv.size() - 1) {
+      if (index == m_arg_count() - 1) {
         return std::format("{}: missing value", token);
       }
 
-      std::string_view next = m_argv[++index];
+      std::string_view next = m_arg(++index);
+      if (m_defer<Vp>(*opt, token, next)) return std::nullopt;
+
       auto value = Vp::parse(next, opt->m_type);
-      if (auto error = m_type_check(token, *value, *opt)) return *error;
-      if (auto error = opt->m_bind(*value)) return *error;
+      if (!value.has_value())
+        return std::format("{}: {}", token, value.error());
+      if (auto error = detail::type_check(token, *value, opt->m_type))
+        return *error;
+      if (auto error = opt->m_bind_value(std::move(*value))) return *error;
     }
     return std::nullopt;
   }
@@ -191,31 +297,119 @@ class parser final {
       return std::format("unexpected positional argument #{}", position);
     }
 
-    auto positional = m_positionals.at(position);
+    argument* positional = m_positionals.at(position);
     positional->m_provided = true;
+    position++;
+    if (m_defer<Vp>(*positional, token, token)) return std::nullopt;
 
     auto value = Vp::parse(token, positional->m_type);
     if (!value.has_value()) return value.error();
-    if (auto error = m_type_check(token, *value, *positional)) return *error;
-    if (auto error = positional->m_bind(*value)) return *error;
-    position++;
+    if (auto error = detail::type_check(token, *value, positional->m_type))
+      return *error;
+    if (auto error = positional->m_bind_value(std::move(*value)))
+      return *error;
     return std::nullopt;
   }
 
-  inline std::optional<std::string> m_type_check(std::string_view name,
-                                                 const value& value,
-                                                 const argument& arg) {
-    const std::type_info& type = std::visit(
-        [](const auto& underlying) -> const std::type_info& {
-          return typeid(underlying);
-        },
-        value);
+  // Hands the token to a lazy argument instead of converting it; returns
+  // false for ordinary arguments.
+  template <detail::value_parser Vp>
+  bool m_defer(argument& arg, std::string_view token, std::string_view raw) {
+    if (!arg.m_defer) return false;
+    arg.m_defer(arg.m_target, token, raw, &detail::convert_with<Vp>);
+    return true;
+  }
 
-    if (type != arg.m_type)
-      return std::format("{}: expected {}, got {} '{}'", name,
-                         detail::type_name(arg.m_type), detail::type_name(type),
-                         detail::to_string(value));
-    return std::nullopt;
+  template <detail::value_alternative T>
+  argument& m_make_lazy(argument& arg) {
+    arg.m_defer = &lazy<T>::m_defer;
+    arg.m_validate = &lazy<T>::m_validate;
+    return arg;
+  }
+
+  argument& m_add_positional(std::string_view name, const std::type_info& type,
+                             void* target, detail::bind_function_t bind) {
+    detail::require(!name.empty(), "positional must have non-empty name");
+
+    std::pmr::vector<std::pmr::string> names(m_alloc);
+    names.emplace_back(name);
+
+    argument* ptr = m_new_argument(std::move(names), type, target, bind);
+    m_positionals.push_back(ptr);
+    return *ptr;
+  }
+
+  argument& m_add_option(detail::option_names option_names,
+                         const std::type_info& type, void* target,
+                         detail::bind_function_t bind) {
+    detail::require(option_names.one_defined(),
+                    "option must have at least one name");
+
+    std::string_view lname = option_names.long_name;
+    std::string_view sname = option_names.short_name;
+    std::pmr::vector<std::pmr::string> names(m_alloc);
+
+    if (!lname.empty()) {
+      detail::require(lname.starts_with(Pp::long_prefix),
+                      "long option name must start with long prefix");
+      names.emplace_back(lname);
+    }
+
+    if (!sname.empty()) {
+      detail::require(sname.starts_with(Pp::short_prefix),
+                      "short option name must start with short prefix");
+      names.emplace_back(sname);
+    }
+
+    argument* ptr = m_new_argument(std::move(names), type, target, bind);
+    if (!lname.empty())
+      m_options.insert_or_assign(std::pmr::string(lname, m_alloc), ptr);
+    if (!sname.empty())
+      m_options.insert_or_assign(std::pmr::string(sname, m_alloc), ptr);
+    return *ptr;
+  }
+
+  argument* m_new_argument(std::pmr::vector<std::pmr::string>&& names,
+                           const std::type_info& type, void* target,
+                           detail::bind_function_t bind) {
+    argument* ptr =
+        m_alloc.new_object<argument>(type, std::move(names), target, bind);
+    m_arguments.push_back(ptr);
+    return ptr;
+  }
+
+  // Copies other's arguments into m_alloc and points the lookup tables at the
+  // copies. Argument counts are small, so copies are found by index.
+  void m_copy_arguments(const parser& other) {
+    for (const argument* ptr : other.m_arguments)
+      m_arguments.push_back(m_alloc.new_object<argument>(*ptr));
+
+    auto copy_of = [&](const argument* ptr) {
+      auto it = std::ranges::find(other.m_arguments, ptr);
+      return m_arguments[it - other.m_arguments.begin()];
+    };
+    for (const argument* ptr : other.m_positionals)
+      m_positionals.push_back(copy_of(ptr));
+    for (const auto& [name, ptr] : other.m_options)
+      m_options.emplace(name, copy_of(ptr));
+  }
+
+  void m_destroy_arguments() {
+    for (argument* ptr : m_arguments) m_alloc.delete_object(ptr);
+    m_clear();
+  }
+
+  void m_clear() {
+    m_arguments.clear();
+    m_positionals.clear();
+    m_options.clear();
+  }
+
+  // Only one of m_argv and m_args is ever non-empty.
+  inline size_t m_arg_count() const { return m_argv.size() + m_args.size(); }
+
+  inline std::string_view m_arg(size_t index) const {
+    return m_argv.empty() ? m_args[index] : std::string_view(m_argv[index]);
   }
 
   inline std::optional<std::string> m_check_required() {
@@ -230,8 +424,14 @@ class parser final {
 
  private:
   std::span<const char* const> m_argv;
-  std::vector<std::shared_ptr<argument>> m_positionals;
-  std::unordered_map<std::string, std::shared_ptr<argument>> m_options;
+  std::span<const std::string_view> m_args;
+
+  std::pmr::polymorphic_allocator<> m_alloc;
+  std::pmr::vector<argument*> m_arguments;  // owning
+  std::pmr::vector<argument*> m_positionals;
+  std::pmr::unordered_map<std::pmr::string, argument*, detail::string_hash,
+                          std::equal_to<>>
+      m_options;
 };
 
 }  // namespace argvx
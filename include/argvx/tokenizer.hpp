@@ -0,0 +1,196 @@
+// argvx - Copyright (C) XnLogicaL 2025
+// Licensed under GNU GPL v3.0; see {root}/LICENSE
+
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <format>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace argvx {
+
+// Shell-style split of a single command string. Tokens are views into the
+// source whenever the token text appears there verbatim (including a token
+// that is exactly one quoted section); only tokens that need quote removal
+// or unescaping are copied, into a single arena sized to the source. As in a
+// shell, a backslash-newline outside single quotes is a line continuation.
+//
+// The source must outlive the command_line. The first token plays the role of
+// argv[0], so the result can be handed straight to parser(args()).
+class command_line final {
+ public:
+  static std::expected<command_line, std::string> tokenize(
+      std::string_view source);
+
+ public:
+  command_line() = default;
+
+  // Re-tokenizes in place, reusing the token list and arena from earlier
+  // calls; views from the previous source are invalidated. On error args() is
+  // left empty.
+  std::optional<std::string> assign(std::string_view source);
+
+ public:
+  std::span<const std::string_view> args() const { return m_args; }
+  size_t size() const { return m_args.size(); }
+
+ private:
+  std::optional<std::string> m_split(std::string_view source);
+
+  // Copies source[begin, end) into the arena with quotes removed and escapes
+  // resolved. The token has already been validated by m_split().
+  std::string_view m_unescape(std::string_view source, size_t begin,
+                              size_t end);
+
+  static void m_put_escaped(char* out, size_t& len, char c) {
+    if (c != '\n') out[len++] = c;
+  }
+
+ private:
+  std::vector<std::string_view> m_args;
+  std::unique_ptr<char[]> m_arena;
+  size_t m_arena_capacity = 0, m_arena_size = 0, m_arena_used = 0;
+};
+
+namespace detail {
+
+constexpr bool is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' ||
+         c == '\f';
+}
+
+// Inside double quotes a backslash only escapes a quote, another backslash or
+// a newline, matching the POSIX shell for the characters a command line cares
+// about.
+constexpr bool is_dquote_escape(char c) {
+  return c == '"' || c == '\\' || c == '\n';
+}
+
+// A backslash-newline outside single quotes is a line continuation: both
+// characters are dropped, joining the text around them.
+constexpr bool is_continuation(std::string_view source, size_t i) {
+  return source[i] == '\\' && i + 1 < source.size() && source[i + 1] == '\n';
+}
+
+}  // namespace detail
+
+inline std::expected<command_line, std::string> command_line::tokenize(
+    std::string_view source) {
+  command_line cmd;
+  if (auto error = cmd.assign(source))
+    return std::unexpected(std::move(*error));
+  return cmd;
+}
+
+inline std::optional<std::string> command_line::assign(
+    std::string_view source) {
+  m_args.clear();
+  m_arena_size = source.size();
+  m_arena_used = 0;
+
+  auto error = m_split(source);
+  if (error) m_args.clear();
+  return error;
+}
+
+inline std::optional<std::string> command_line::m_split(
+    std::string_view source) {
+  size_t i = 0, n = source.size();
+  while (true) {
+    while (i < n && (detail::is_space(source[i]) ||
+                     detail::is_continuation(source, i)))
+      i += source[i] == '\\' ? 2 : 1;
+    if (i == n) break;
+
+    size_t begin = i, sections = 0;
+    bool escaped = false, unquoted = false;
+
+    while (i < n && !detail::is_space(source[i])) {
+      char c = source[i];
+      if (c == '\\') {
+        if (i + 1 == n) return std::format("trailing backslash at {}", i);
+        escaped = true;
+        i += 2;
+      } else if (c == '\'') {
+        auto close = source.find('\'', i + 1);
+        if (close == std::string_view::npos)
+          return std::format("unterminated quote at {}", i);
+        sections++;
+        i = close + 1;
+      } else if (c == '"') {
+        size_t open = i++;
+        while (i < n && source[i] != '"') {
+          if (source[i] == '\\' && i + 1 < n &&
+              detail::is_dquote_escape(source[i + 1])) {
+            escaped = true;
+            i++;
+          }
+          i++;
+        }
+        if (i >= n) return std::format("unterminated quote at {}", open);
+        sections++;
+        i++;
+      } else {
+        unquoted = true;
+        i++;
+      }
+    }
+
+    if (!escaped && sections == 0)
+      m_args.push_back(source.substr(begin, i - begin));
+    else if (!escaped && sections == 1 && !unquoted)
+      m_args.push_back(source.substr(begin + 1, i - begin - 2));
+    else
+      m_args.push_back(m_unescape(source, begin, i));
+  }
+
+  return std::nullopt;
+}
+
+inline std::string_view command_line::m_unescape(std::string_view source,
+                                                 size_t begin, size_t end) {
+  // Unescaped text is never longer than its source span, and spans don't
+  // overlap, so one source-sized block is enough for every token.
+  if (m_arena_capacity < m_arena_size) {
+    m_arena = std::make_unique_for_overwrite<char[]>(m_arena_size);
+    m_arena_capacity = m_arena_size;
+  }
+
+  char* out = m_arena.get() + m_arena_used;
+  size_t len = 0;
+  char quote = '\0';
+
+  for (size_t i = begin; i < end; ++i) {
+    char c = source[i];
+    if (quote == '\'') {
+      if (c == '\'')
+        quote = '\0';
+      else
+        out[len++] = c;
+    } else if (quote == '"') {
+      if (c == '"')
+        quote = '\0';
+      else if (c == '\\' && detail::is_dquote_escape(source[i + 1]))
+        m_put_escaped(out, len, source[++i]);
+      else
+        out[len++] = c;
+    } else if (c == '\'' || c == '"') {
+      quote = c;
+    } else if (c == '\\') {
+      m_put_escaped(out, len, source[++i]);
+    } else {
+      out[len++] = c;
+    }
+  }
+
+  m_arena_used += len;
+  return std::string_view(out, len);
+}
+
+}  // namespace argvx
@@ -0,0 +1,37 @@
+// argvx - Copyright (C) XnLogicaL 2025
+// Licensed under GNU GPL v3.0; see {root}/LICENSE
+
+module;
+
+#include <argvx/batch.hpp>
+#include <argvx/lazy.hpp>
+#include <argvx/live.hpp>
+#include <argvx/parser.hpp>
+#include <argvx/tokenizer.hpp>
+
+export module argvx;
+
+// The headers stay the single source of truth; the module only re-exports
+// the public surface so importers skip re-parsing the standard headers.
+export namespace argvx {
+
+using argvx::argument;
+using argvx::default_value_parser;
+using argvx::delim_policy;
+using argvx::parser;
+using argvx::prefix_policy;
+using argvx::value;
+
+// live.hpp
+using argvx::live;
+
+// tokenizer.hpp
+using argvx::command_line;
+
+// batch.hpp
+using argvx::batch;
+
+// lazy.hpp
+using argvx::lazy;
+
+}  // namespace argvx
@@ -0,0 +1,40 @@
+// argvx - Copyright (C) XnLogicaL 2025
+// Licensed under GNU GPL v3.0; see {root}/LICENSE
+
+// Checks that `import argvx;` compiles, links and parses. Built only with
+// ARGVX_BUILD_MODULE and ARGVX_BUILD_TEST.
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+import argvx;
+
+int main() {
+  auto cmd = argvx::command_line::tokenize("prog 'in file' --jobs=4 -v");
+  if (!cmd.has_value()) {
+    std::printf("tokenize failed: %s\n", cmd.error().c_str());
+    return 1;
+  }
+
+  std::string input;
+  int64_t jobs = 1;
+  argvx::lazy<bool> verbose;
+
+  argvx::parser<> parser(cmd->args());
+  parser.positional("input", input).required();
+  parser.option({"--jobs", "-j"}, jobs);
+  parser.option({"--verbose", "-v"}, verbose);
+
+  if (auto error = parser.parse()) {
+    std::printf("parse failed: %s\n", error->c_str());
+    return 1;
+  }
+  if (input != "in file" || jobs != 4 || !*verbose.get()) {
+    std::printf("unexpected values\n");
+    return 1;
+  }
+
+  std::printf("[+] module smoke test passed\n");
+  return 0;
+}
@@ -1,11 +1,37 @@
+#include <argvx/batch.hpp>
+#include <argvx/lazy.hpp>
+#include <argvx/live.hpp>
 #include <argvx/parser.hpp>
+#include <argvx/tokenizer.hpp>
+#include <atomic>
+#include <cstdlib>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <memory_resource>
+#include <new>
+#include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace std::string_literals;
 
+static std::atomic<size_t> global_allocations = 0;
+
+void* operator new(std::size_t size) {
+  global_allocations++;
+  if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+  throw std::bad_alloc();
+}
+
+// Kept out of line: once inlined, GCC sees free() applied to a pointer from
+// operator new and warns (-Wmismatched-new-delete) at every call site.
+[[gnu::noinline]] void operator delete(void* ptr) noexcept { std::free(ptr); }
+[[gnu::noinline]] void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
 static std::vector<std::string> arg_storage;
 
 static std::vector<char*> make_argv(std::initializer_list<std::string> args) {
@@ -172,6 +198,474 @@ TEST(error_propagates_from_value_parser) {
   check(err.has_value(), "missing value should error");
 }
 
+struct tunables {
+  int64_t low = 0, high = 0;
+  bool verbose = false;
+};
+
+static void tunables_schema(argvx::parser<>& parser, tunables& t) {
+  parser.option({"--low"}, t.low);
+  parser.option({"--high"}, t.high);
+  parser.option({"--verbose", "-v"}, t.verbose);
+}
+
+TEST(live_reload_publishes_snapshot) {
+  argvx::live<tunables> live(tunables_schema);
+  check(live.read()->low == 0, "initial snapshot should hold defaults");
+
+  auto argv = make_argv({"prog", "--low=4", "--high=4", "-v"});
+  auto err = live.reload(argv.size(), argv.data());
+  check(!err.has_value(), "reload should succeed");
+
+  auto snap = live.read();
+  check(snap->low == 4 && snap->high == 4, "reload should publish values");
+  check_eq_any(snap->verbose, true, "reload should publish flags");
+}
+
+TEST(live_failed_reload_keeps_snapshot) {
+  argvx::live<tunables> live(tunables_schema);
+
+  auto good = make_argv({"prog", "--low=8"});
+  live.reload(good.size(), good.data());
+
+  auto bad = make_argv({"prog", "--low=16", "--high=nope"});
+  auto err = live.reload(bad.size(), bad.data());
+  check(err.has_value(), "bad reload should fail");
+  check(live.read()->low == 8, "failed reload must not publish");
+}
+
+TEST(live_reload_while_holding_snapshot) {
+  argvx::live<tunables> live(tunables_schema);
+
+  std::optional<argvx::live<tunables>::snapshot> held;
+  held.emplace(live.read());
+  auto moved = std::move(*held);
+  held.reset();
+
+  auto argv = make_argv({"prog", "--low=2"});
+  auto err = live.reload(argv.size(), argv.data());
+  check(!err.has_value(), "reload must not wait for held snapshots");
+  check(moved->low == 0, "held snapshot should keep its value");
+  check(live.read()->low == 2, "reload should publish immediately");
+  check(!live.try_reclaim(), "held snapshot must not be reclaimed");
+
+  { auto released = std::move(moved); }
+  check(live.try_reclaim(), "released snapshot should be reclaimed");
+}
+
+TEST(live_readers_see_consistent_snapshots) {
+  argvx::live<tunables> live(tunables_schema);
+  std::atomic<bool> done = false, torn = false;
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i)
+    readers.emplace_back([&] {
+      while (!done) {
+        auto snap = live.read();
+        if (snap->low != snap->high) torn = true;
+      }
+    });
+
+  for (int i = 1; i <= 200; ++i) {
+    std::string low = "--low=" + std::to_string(i);
+    std::string high = "--high=" + std::to_string(i);
+    const char* argv[] = {"prog", low.c_str(), high.c_str()};
+    live.reload(3, argv);
+  }
+
+  done = true;
+  for (auto& reader : readers) reader.join();
+  check(!torn, "reader observed a torn snapshot");
+  check(live.read()->low == 200, "last reload should win");
+}
+
+static bool views_into(std::string_view token, std::string_view source) {
+  return token.data() >= source.data() &&
+         token.data() + token.size() <= source.data() + source.size();
+}
+
+TEST(tokenize_splits_whitespace_and_quotes) {
+  std::string_view source = "prog  in.txt\t'a b' \"c d\"  ";
+  auto cmd = argvx::command_line::tokenize(source);
+  check(cmd.has_value(), "tokenize should succeed");
+  check(cmd->size() == 4, "expected 4 tokens");
+  check(cmd->args()[1] == "in.txt", "plain token mismatch");
+  check(cmd->args()[2] == "a b", "single-quoted token mismatch");
+  check(cmd->args()[3] == "c d", "double-quoted token mismatch");
+  for (auto token : cmd->args())
+    check(views_into(token, source), "verbatim token should not be copied");
+}
+
+TEST(tokenize_unescapes_into_arena) {
+  std::string_view source = R"(prog --name="x \"y\"" a\ b 'it''s' "")";
+  auto cmd = argvx::command_line::tokenize(source);
+  check(cmd.has_value(), "tokenize should succeed");
+  check(cmd->size() == 5, "expected 5 tokens");
+  check(cmd->args()[1] == R"(--name=x "y")", "escaped quote mismatch");
+  check(cmd->args()[2] == "a b", "escaped space mismatch");
+  check(cmd->args()[3] == "its", "adjacent quotes should concatenate");
+  check(cmd->args()[4].empty(), "empty quotes should yield empty token");
+  check(!views_into(cmd->args()[1], source), "escaped token should be copied");
+}
+
+TEST(tokenize_joins_line_continuations) {
+  auto cmd = argvx::command_line::tokenize(
+      "prog a\\\nb \"c\\\nd\" 'e\\\nf' g \\\n h\\\n");
+  check(cmd.has_value(), "tokenize should succeed");
+  check(cmd->size() == 6, "expected 6 tokens");
+  check(cmd->args()[1] == "ab", "unquoted continuation should join");
+  check(cmd->args()[2] == "cd", "double-quoted continuation should join");
+  check(cmd->args()[3] == "e\\\nf", "single quotes keep backslash-newline");
+  check(cmd->args()[4] == "g" && cmd->args()[5] == "h",
+        "standalone continuation should act as whitespace");
+}
+
+TEST(tokenize_rejects_unterminated_input) {
+  check(!argvx::command_line::tokenize("prog 'oops").has_value(),
+        "unterminated single quote should fail");
+  check(!argvx::command_line::tokenize("prog \"oops").has_value(),
+        "unterminated double quote should fail");
+  check(!argvx::command_line::tokenize("prog oops\\").has_value(),
+        "trailing backslash should fail");
+}
+
+TEST(command_line_assign_reuses_buffers) {
+  argvx::command_line cmd;
+  check(!cmd.assign("prog 'a b' \"c\\\"d\"").has_value(), "first assign");
+  check(cmd.size() == 3 && cmd.args()[2] == "c\"d", "first tokens");
+
+  check(!cmd.assign("tool x\\ y").has_value(), "second assign");
+  check(cmd.size() == 2 && cmd.args()[1] == "x y", "second tokens");
+
+  check(cmd.assign("tool 'oops").has_value(), "bad input should fail");
+  check(cmd.size() == 0, "failed assign should leave no tokens");
+}
+
+TEST(tokenize_feeds_parser) {
+  auto cmd = argvx::command_line::tokenize(
+      "prog --do-thing 'src/my in' -o \"dst/out\"");
+
+  bool do_thing = false;
+  std::filesystem::path in, out;
+
+  argvx::parser parser(cmd->args());
+  parser.positional("input", in).required();
+  parser.option({"--output", "-o"}, out).required();
+  parser.option({"--do-thing", "-do"}, do_thing);
+
+  auto err = parser.parse();
+  check(!err.has_value(), "parse from command_line should succeed");
+  check_eq_any(do_thing, true, "flag was not parsed correctly");
+  check_eq_any(in, "src/my in", "input mismatch");
+  check_eq_any(out, "dst/out", "output mismatch");
+}
+
+struct job {
+  int64_t jobs = 1;
+  std::string target;
+};
+
+static void job_schema(argvx::parser<>& parser, job& j) {
+  parser.positional("target", j.target).required();
+  parser.option({"--jobs", "-j"}, j.jobs);
+}
+
+TEST(batch_parses_lines_with_errors) {
+  argvx::batch<job> batch(job_schema, {}, 2);
+  auto res = batch.parse(
+      "tool a -j 4\n"
+      "\n"
+      "tool --jobs=nope b\n"
+      "tool 'c d'\n"
+      "tool --jobs=2\n"
+      "tool e -j nope\n");
+
+  check(res.values.size() == 6, "expected one slot per line");
+  check(res.values[0].target == "a" && res.values[0].jobs == 4, "line 1");
+  check(res.values[1].target.empty(), "blank line should keep defaults");
+  check(res.values[3].target == "c d" && res.values[3].jobs == 1, "line 4");
+  check(res.errors.size() == 3, "expected 3 errors");
+  check(res.errors[0].line == 3, "bad value should be reported on line 3");
+  check(res.errors[1].line == 5, "missing target should be on line 5");
+  check(res.errors[2].line == 6, "bad short value should be on line 6");
+}
+
+TEST(batch_threads_match_serial) {
+  // Large enough to span several chunks, with blank and failing lines mixed
+  // in so line numbering across chunk boundaries is checked too.
+  std::string manifest;
+  for (int i = 0; i < 10000; ++i)
+    manifest += i % 97 == 0 ? "\n"
+                : i % 89 == 0
+                    ? std::format("tool t{} --jobs=nope\n", i)
+                    : std::format("tool t{} --jobs={}\n", i, i % 7 ? i : -1);
+
+  auto serial = argvx::batch<job>(job_schema, {}, 1).parse(manifest);
+  auto parallel = argvx::batch<job>(job_schema, {}, 8).parse(manifest);
+
+  check(serial.values.size() == 10000, "expected one slot per line");
+  check(serial.errors.size() == parallel.errors.size(), "same error count");
+  check(serial.errors.size() == 111 && serial.errors[0].line == 90,
+        "failing lines should be reported");
+  bool same = serial.values.size() == parallel.values.size();
+  for (size_t i = 0; same && i < serial.values.size(); ++i)
+    same = serial.values[i].target == parallel.values[i].target &&
+           serial.values[i].jobs == parallel.values[i].jobs;
+  for (size_t i = 0; same && i < serial.errors.size(); ++i)
+    same = serial.errors[i].line == parallel.errors[i].line;
+  check(same, "parallel results should match serial results");
+}
+
+TEST(batch_parses_mapped_file) {
+  auto path = std::filesystem::temp_directory_path() / "argvx-batch-test.txt";
+  std::ofstream(path) << "tool x -j 3\ntool y\n";
+
+  auto res = argvx::batch<job>(job_schema).parse_file(path);
+  std::filesystem::remove(path);
+
+  check(res.has_value(), "parse_file should succeed");
+  check(res->values.size() == 2 && res->values[0].jobs == 3, "file values");
+  check(!argvx::batch<job>(job_schema).parse_file(path).has_value(),
+        "missing file should fail");
+}
+
+TEST(pmr_parser_avoids_global_allocations) {
+  auto argv = make_argv({"prog", "in.txt", "--jobs=8", "-n", "short", "-v"});
+
+  alignas(std::max_align_t) std::byte buffer[16384];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                            std::pmr::null_memory_resource());
+
+  int64_t jobs = 0;
+  bool verbose = false, failed = false;
+  std::string name;
+  std::filesystem::path in;
+
+  size_t before = global_allocations;
+  {
+    argvx::parser parser(argv.size(), argv.data(), &arena);
+    parser.positional("input", in).required();
+    parser.option({"--jobs", "-j"}, jobs).help(
+        "number of worker threads to spawn for the build");
+    parser.option({"--name", "-n"}, name);
+    parser.option({"--verbose-output-for-debugging", "-v"}, verbose);
+
+    failed = parser.parse().has_value();
+  }
+  size_t allocations = global_allocations - before;
+
+  check(!failed, "arena-backed parse should succeed");
+  check(jobs == 8 && verbose && name == "short", "arena-backed values");
+  check_eq_any(in, "in.txt", "arena-backed path");
+
+  check(allocations == 0, "registration + parse allocated " +
+                              std::to_string(allocations) + " times");
+}
+
+TEST(pmr_parser_allocates_only_for_bound_values) {
+  const std::string_view path = "src/dir/main.cpp";
+  const std::string_view name = "a name too long for the small buffer";
+  auto argv = make_argv({"prog", std::string(path), "-n", std::string(name)});
+
+  // What the bound types allocate on their own when built from the tokens.
+  size_t before = global_allocations;
+  {
+    std::filesystem::path in(path);
+    std::string out(name);
+  }
+  size_t expected = global_allocations - before;
+
+  alignas(std::max_align_t) std::byte buffer[16384];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                            std::pmr::null_memory_resource());
+
+  std::string out;
+  std::filesystem::path in;
+  bool failed = false;
+
+  before = global_allocations;
+  {
+    argvx::parser parser(argv.size(), argv.data(), &arena);
+    parser.positional("input", in).required();
+    parser.option({"--name", "-n"}, out);
+
+    failed = parser.parse().has_value();
+  }
+  size_t allocations = global_allocations - before;
+
+  check(!failed, "arena-backed parse should succeed");
+  check_eq_any(in, path, "multi-component path");
+  check(out == name, "long string value");
+  check(allocations == expected,
+        std::format("expected {} allocations from bound values, got {}",
+                    expected, allocations));
+}
+
+struct counting_value_parser {
+  static inline int calls = 0;
+
+  static std::expected<argvx::value, std::string> parse(
+      std::string_view sv, const std::type_info& type) {
+    calls++;
+    return argvx::default_value_parser::parse(sv, type);
+  }
+};
+
+TEST(lazy_converts_on_first_access) {
+  auto argv = make_argv({"prog", "in.txt", "--jobs=8", "-o", "out.txt"});
+
+  argvx::lazy<std::filesystem::path> in, out;
+  argvx::lazy<int64_t> jobs;
+
+  argvx::parser parser(argv.size(), argv.data());
+  parser.positional("input", in).required();
+  parser.option({"--output", "-o"}, out);
+  parser.option({"--jobs", "-j"}, jobs);
+
+  counting_value_parser::calls = 0;
+  auto err = parser.parse<counting_value_parser>();
+  check(!err.has_value(), "lazy parse should succeed");
+  check(counting_value_parser::calls == 0, "parse() should not convert");
+
+  check(jobs.get().has_value() && *jobs.get() == 8, "lazy int64 mismatch");
+  check(jobs.get().has_value(), "cached result should be reused");
+  check(counting_value_parser::calls == 1, "conversion should be cached");
+
+  check_eq_any(*in.get(), "in.txt", "lazy positional mismatch");
+  check_eq_any(*out.get(), "out.txt", "lazy short option mismatch");
+}
+
+TEST(lazy_defers_conversion_errors) {
+  auto argv = make_argv({"prog", "--jobs=nope", "--verbose"});
+
+  argvx::lazy<int64_t> jobs;
+  argvx::lazy<double> ratio(0.5);
+  argvx::lazy<bool> verbose;
+
+  argvx::parser parser(argv.size(), argv.data());
+  parser.option({"--jobs", "-j"}, jobs);
+  parser.option({"--ratio"}, ratio);
+  parser.option({"--verbose", "-v"}, verbose);
+
+  auto err = parser.parse();
+  check(!err.has_value(), "bad lazy value should not fail parse()");
+  check(!jobs.get().has_value(), "bad lazy value should fail on access");
+  check(parser.validate_all().has_value(), "validate_all should fail");
+  check(!ratio.provided() && *ratio.get() == 0.5, "fallback mismatch");
+  check_eq_any(*verbose.get(), true, "lazy flag should be true");
+}
+
+TEST(lazy_bool_matches_eager_fallback) {
+  auto argv = make_argv({"prog", "--verbose=garbage", "--quiet=garbage"});
+
+  bool verbose = false;
+  argvx::lazy<bool> quiet;
+
+  argvx::parser parser(argv.size(), argv.data());
+  parser.option({"--verbose"}, verbose);
+  parser.option({"--quiet"}, quiet);
+
+  check(!parser.parse().has_value(), "parse should succeed");
+  check_eq_any(verbose, true, "eager flag should fall back to true");
+  check(quiet.get().has_value() && *quiet.get(), "lazy flag should match");
+}
+
+TEST(lazy_still_checks_syntax) {
+  auto argv = make_argv({"prog", "-j"});
+
+  argvx::lazy<int64_t> jobs;
+  argvx::parser parser(argv.size(), argv.data());
+  parser.option({"--jobs", "-j"}, jobs);
+
+  check(parser.parse().has_value(), "missing value should fail parse()");
+
+  auto long_argv = make_argv({"prog", "--jobs"});
+  argvx::parser long_parser(long_argv.size(), long_argv.data());
+  long_parser.option({"--jobs", "-j"}, jobs);
+
+  auto err = long_parser.parse();
+  check(err == "--jobs: missing value", "long option without '=' should fail");
+  check(!jobs.provided(), "rejected option should not be recorded");
+}
+
+TEST(parser_is_movable) {
+  auto argv = make_argv({"prog", "in.txt", "-o", "out.txt"});
+
+  std::filesystem::path in, out;
+  argvx::parser<> assigned(argv.size(), argv.data());
+  {
+    std::byte buffer[4096];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+
+    argvx::parser source(argv.size(), argv.data(), &arena);
+    source.positional("input", in).required();
+    source.option({"--output", "-o"}, out).required();
+
+    argvx::parser moved(std::move(source));
+    source.reset({});
+    check(!source.parse().has_value(), "moved-from parser should be empty");
+
+    assigned = std::move(moved);
+  }
+
+  // The arena is gone: move-assignment must have re-created the arguments in
+  // the target's own resource.
+  auto err = assigned.parse();
+  check(!err.has_value(), "move-assigned parser should parse");
+  check_eq_any(in, "in.txt", "input mismatch");
+  check_eq_any(out, "out.txt", "output mismatch");
+}
+
+struct lazy_job {
+  argvx::lazy<int64_t> jobs{1};
+  argvx::lazy<std::string> target;
+};
+
+static void lazy_job_schema(argvx::parser<>& parser, lazy_job& j) {
+  parser.positional("target", j.target);
+  parser.option({"--jobs", "-j"}, j.jobs);
+}
+
+TEST(live_forces_lazy_members) {
+  argvx::live<lazy_job> live(lazy_job_schema);
+
+  auto bad = make_argv({"prog", "--jobs=nope"});
+  check(live.reload(bad.size(), bad.data()).has_value(),
+        "bad lazy value should fail the reload");
+
+  {
+    std::vector<std::string> storage = {"prog", "tgt", "--jobs=6"};
+    std::vector<const char*> argv;
+    for (auto& arg : storage) argv.push_back(arg.c_str());
+    check(!live.reload(argv.size(), argv.data()).has_value(),
+          "reload should succeed");
+  }
+
+  std::atomic<bool> wrong = false;
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i)
+    readers.emplace_back([&] {
+      auto snap = live.read();
+      if (*snap->jobs.get() != 6 || *snap->target.get() != "tgt") wrong = true;
+    });
+  for (auto& reader : readers) reader.join();
+  check(!wrong, "lazy members should be converted before publishing");
+}
+
+TEST(batch_forces_lazy_members) {
+  auto path = std::filesystem::temp_directory_path() / "argvx-lazy-batch.txt";
+  std::ofstream(path) << "tool a -j 3\ntool b --jobs=nope\n";
+
+  auto res = argvx::batch<lazy_job>(lazy_job_schema, {}, 2).parse_file(path);
+  std::filesystem::remove(path);
+
+  check(res.has_value(), "parse_file should succeed");
+  check(res->errors.size() == 1 && res->errors[0].line == 2,
+        "bad lazy value should be reported on line 2");
+  check(*res->values[0].jobs.get() == 3 && *res->values[0].target.get() == "a",
+        "lazy values should outlive the mapping");
+}
+
 int main() {
   if (failures == 0) {
     std::cout << "[+] all tests passed\n";